@@ -405,17 +405,24 @@ void DogMatchingGame::displayCongratulations() {
 
 // Save game result
 void DogMatchingGame::saveGameResult() {
-    // Open file to append result
+    // Get current time
+    time_t now = time(0);
+    char dt[26];
+    strftime(dt, sizeof(dt), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    std::string datetime(dt);
+    
+    std::string result = "Player: " + playerName + " | Score: " + std::to_string(correctAnswers) + "/6 (" +
+                         std::to_string(correctAnswers * 100 / 6) + "%) | Date: " + datetime;
+    
+    // Hand the result to the collector process if one is running
+    if (resultsRing.push(result)) {
+        return;
+    }
+    
+    // Otherwise open file to append result
     std::ofstream resultFile("game_results.txt", std::ios::app);
     if (resultFile.is_open()) {
-        // Get current time
-        time_t now = time(0);
-        char dt[26];
-        strftime(dt, sizeof(dt), "%Y-%m-%d %H:%M:%S", localtime(&now));
-        std::string datetime(dt);
-        
-        resultFile << "Player: " << playerName << " | Score: " << correctAnswers << "/6 (" 
-                  << (correctAnswers * 100 / 6) << "%) | Date: " << datetime << std::endl;
+        resultFile << result << std::endl;
         resultFile.close();
     }
 }
@@ -423,6 +430,7 @@ void DogMatchingGame::saveGameResult() {
 // Constructor
 DogMatchingGame::DogMatchingGame() {
     initializeDogBreeds();
+    resultsRing.attach();
     currentQuestion = 0;
     correctAnswers = 0;
     gameRunning = false;
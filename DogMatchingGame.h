@@ -4,11 +4,13 @@
 #include <string>
 #include <vector>
 #include "DogBreed.h"
+#include "SharedMemory.h"
 
 // Game class
 class DogMatchingGame {
 private:
     std::vector<DogBreed> allDogBreeds; // All dog breeds
+    ResultsRing resultsRing;            // Host-wide queue of finished games
     std::vector<DogBreed> gameBreeds;   // Breeds selected for this round
     int currentQuestion;           // Current question
     int correctAnswers;            // Number of correct answers
@@ -0,0 +1,463 @@
+#include "SharedMemory.h"
+#include <iostream>
+#include <fstream>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Segment name under /dev/shm
+const char* const kResultsName = "/dog_matching_results";
+
+// How long to wait for another process to finish creating a segment (100 x 10ms)
+const int kWaitRetries = 100;
+const useconds_t kWaitStepUs = 10000;
+
+// How long an idle collector waits for a push before its next heartbeat
+const long kCollectorPollNs = 200000000;
+
+// A collector whose heartbeat is older than this is treated as gone
+const uint32_t kCollectorStaleSeconds = 3;
+
+// A claimed slot still unwritten after this long belongs to a producer that died
+const uint32_t kStalledSlotSeconds = 2;
+
+// How long a stopping collector waits for producers still pushing (50 x 100ms)
+const int kShutdownRetries = 50;
+const useconds_t kShutdownStepUs = 100000;
+
+// Cleared by SIGINT/SIGTERM to stop the collector loop
+volatile sig_atomic_t collectorRunning = 1;
+
+void stopCollector(int) {
+    collectorRunning = 0;
+}
+
+// Create a segment exclusively and map it writable, null if it already exists
+void* createExclusive(const char* name, size_t size, mode_t mode) {
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, mode);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    // Apply the mode as given, regardless of the umask
+    fchmod(fd, mode);
+
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, size) == 0) {
+        mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (mapped == MAP_FAILED) {
+        shm_unlink(name);
+        return nullptr;
+    }
+    return mapped;
+}
+
+// Outcome of mapping an existing segment
+enum MapStatus {
+    kMapped,   // Mapped and owned by this user
+    kMissing,  // No segment with that name (any more)
+    kUnsized,  // Owned by this user but never sized, its creator died or uses another layout
+    kRefused   // Owned by someone else or not accessible
+};
+
+// Map an existing segment once its creator has sized it, only if it belongs to this user
+MapStatus mapExisting(const char* name, size_t size, void*& mapped) {
+    mapped = nullptr;
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return errno == ENOENT ? kMissing : kRefused;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_uid != geteuid()) {
+        close(fd);
+        return kRefused;
+    }
+
+    bool sized = false;
+    for (int i = 0; i < kWaitRetries && !sized; i++) {
+        sized = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= size;
+        if (!sized) {
+            usleep(kWaitStepUs);
+        }
+    }
+
+    MapStatus status = kRefused;
+    if (!sized) {
+        status = kUnsized;
+    } else {
+        void* result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (result != MAP_FAILED) {
+            mapped = result;
+            status = kMapped;
+        }
+    }
+    close(fd);
+
+    return status;
+}
+
+// Wait for the creating process to publish the segment
+bool waitReady(const std::atomic<uint32_t>& ready) {
+    for (int i = 0; i < kWaitRetries; i++) {
+        if (ready.load(std::memory_order_acquire) != 0) {
+            return true;
+        }
+        usleep(kWaitStepUs);
+    }
+    return false;
+}
+
+// Monotonic clock in whole seconds, shared by every process on the host
+uint32_t monotonicSeconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint32_t>(now.tv_sec);
+}
+
+// Pack a collector registration into the shared word
+uint64_t collectorWord(pid_t pid, uint32_t beat) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 32) | beat;
+}
+
+// Pid stored in a collector registration
+pid_t collectorPid(uint64_t word) {
+    return static_cast<pid_t>(word >> 32);
+}
+
+// Has this registration sent a heartbeat recently; a pid alone can be reused after a crash
+bool collectorFresh(uint64_t word) {
+    uint32_t beat = static_cast<uint32_t>(word);
+    return word != 0 && monotonicSeconds() - beat <= kCollectorStaleSeconds;
+}
+
+} // namespace
+
+// Constructor
+ResultsRing::ResultsRing() : segment(nullptr), stallSeen(false), stalledAt(0), stalledSince(0) {
+}
+
+// Destructor
+ResultsRing::~ResultsRing() {
+    if (segment) {
+        munmap(segment, sizeof(ResultsSegment));
+    }
+}
+
+// Map the ring, creating it if needed
+bool ResultsRing::attach() {
+    if (segment) {
+        return true;
+    }
+
+    // A ring left half-built by a crashed process or from another layout is replaced once
+    for (int attempt = 0; attempt < 2; attempt++) {
+        // New segments are zero-filled, which is already an empty ring with every slot free
+        void* created = createExclusive(kResultsName, sizeof(ResultsSegment), 0600);
+        if (created) {
+            ResultsSegment* fresh = static_cast<ResultsSegment*>(created);
+            if (sem_init(&fresh->wakeup, 1, 0) != 0) {
+                munmap(created, sizeof(ResultsSegment));
+                shm_unlink(kResultsName);
+                return false;
+            }
+            fresh->version = ResultsSegment::kVersion;
+            fresh->ready.store(1, std::memory_order_release);
+            segment = fresh;
+            return true;
+        }
+
+        void* mapped = nullptr;
+        MapStatus status = mapExisting(kResultsName, sizeof(ResultsSegment), mapped);
+        if (status == kRefused) {
+            return false;
+        }
+        if (status == kMapped) {
+            ResultsSegment* existing = static_cast<ResultsSegment*>(mapped);
+            if (waitReady(existing->ready) && existing->version == ResultsSegment::kVersion) {
+                segment = existing;
+                return true;
+            }
+            munmap(mapped, sizeof(ResultsSegment));
+        }
+        if (status != kMissing) {
+            shm_unlink(kResultsName);
+        }
+    }
+    return false;
+}
+
+// Is a collector process currently draining the ring
+bool ResultsRing::hasCollector() const {
+    return segment && collectorFresh(segment->collector.load());
+}
+
+// Queue one result line for the running collector, returns false if there is none,
+// the ring is full or unavailable; the caller then writes the line itself
+bool ResultsRing::push(const std::string& line) {
+    if (!hasCollector() || !enqueue(line)) {
+        return false;
+    }
+
+    // Wake the collector so a burst is drained before the ring fills up
+    sem_post(&segment->wakeup);
+    return true;
+}
+
+// Is every claimed slot consumed (collector only)
+bool ResultsRing::idle() const {
+    return !segment || segment->head.load() == segment->tail.load();
+}
+
+// Write one line into the next free slot, returns false if the ring is full
+bool ResultsRing::enqueue(const std::string& line) {
+    if (line.size() >= static_cast<size_t>(ResultSlot::kLineSize)) {
+        return false;
+    }
+
+    // Slot sequence for position pos is 2 * lap while free and 2 * lap + 1 once written
+    uint64_t pos = segment->head.load(std::memory_order_relaxed);
+    for (;;) {
+        ResultSlot& slot = segment->slots[pos % ResultsSegment::kSlotCount];
+        uint64_t freeSequence = 2 * (pos / ResultsSegment::kSlotCount);
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence == freeSequence) {
+            // Claim the position; on failure pos is reloaded and we retry
+            if (segment->head.compare_exchange_weak(pos, pos + 1)) {
+                memcpy(slot.line, line.c_str(), line.size() + 1);
+
+                // A stopping collector clears its registration before its last look at head,
+                // so either it waits for this slot or we see it gone and give the slot up
+                bool queued = hasCollector();
+                if (!queued) {
+                    slot.line[0] = '\0';
+                }
+
+                // Publish unless the collector already skipped this slot as stalled
+                uint64_t expected = freeSequence;
+                return slot.sequence.compare_exchange_strong(expected, freeSequence + 1) && queued;
+            }
+        } else if (sequence < freeSequence) {
+            // The collector has not consumed this slot's previous lap yet
+            return false;
+        } else {
+            // Another producer took this position
+            pos = segment->head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Take the oldest result line (collector only), returns false if empty
+bool ResultsRing::pop(std::string& line) {
+    if (!segment) {
+        return false;
+    }
+
+    uint64_t pos = segment->tail.load(std::memory_order_acquire);
+    ResultSlot& slot = segment->slots[pos % ResultsSegment::kSlotCount];
+    uint64_t fullSequence = 2 * (pos / ResultsSegment::kSlotCount) + 1;
+
+    if (slot.sequence.load(std::memory_order_acquire) != fullSequence) {
+        return false;
+    }
+
+    // Claim the position so a collector resuming after a takeover can never read it twice
+    // or move tail backwards; the slot stays full, so no producer reuses it meanwhile
+    if (!segment->tail.compare_exchange_strong(pos, pos + 1, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    line.assign(slot.line, strnlen(slot.line, sizeof(slot.line)));
+    slot.sequence.store(fullSequence + 1, std::memory_order_release);
+    return true;
+}
+
+// Skip the oldest slot if its producer claimed it and died before writing it
+// (collector only), returns true if a slot was skipped
+bool ResultsRing::skipStalled() {
+    if (!segment) {
+        return false;
+    }
+
+    uint64_t pos = segment->tail.load();
+    ResultSlot& slot = segment->slots[pos % ResultsSegment::kSlotCount];
+    uint64_t freeSequence = 2 * (pos / ResultsSegment::kSlotCount);
+
+    // Only a claimed slot that is still unwritten can stall the ring
+    if (pos == segment->head.load() || slot.sequence.load() != freeSequence) {
+        stallSeen = false;
+        return false;
+    }
+
+    uint32_t now = monotonicSeconds();
+    if (!stallSeen || stalledAt != pos) {
+        stallSeen = true;
+        stalledAt = pos;
+        stalledSince = now;
+        return false;
+    }
+    if (now - stalledSince < kStalledSlotSeconds) {
+        return false;
+    }
+
+    // Mark the slot consumed; a producer that was only slow then fails to publish and
+    // writes its line to the file itself
+    stallSeen = false;
+    uint64_t expected = freeSequence;
+    if (!slot.sequence.compare_exchange_strong(expected, freeSequence + 2)) {
+        return false;
+    }
+    segment->tail.compare_exchange_strong(pos, pos + 1);
+    return true;
+}
+
+// Sleep until a producer pushes or the poll interval passes (collector only)
+void ResultsRing::waitForPush() {
+    if (!segment) {
+        return;
+    }
+
+    // sem_timedwait takes an absolute CLOCK_REALTIME deadline; a signal also ends the wait
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += kCollectorPollNs;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    sem_timedwait(&segment->wakeup, &deadline);
+}
+
+// Register this process as the collector, returns false if another one is alive
+bool ResultsRing::claimCollector() {
+    if (!segment) {
+        return false;
+    }
+
+    pid_t self = getpid();
+    uint64_t current = segment->collector.load();
+    for (;;) {
+        if (collectorFresh(current) && collectorPid(current) != self) {
+            return false;
+        }
+        // Take over an empty or stale registration
+        if (segment->collector.compare_exchange_weak(current, collectorWord(self, monotonicSeconds()))) {
+            return true;
+        }
+    }
+}
+
+// Tell producers this collector is still alive, returns false if another one took over
+bool ResultsRing::heartbeat() {
+    if (!segment) {
+        return false;
+    }
+
+    pid_t self = getpid();
+    uint64_t current = segment->collector.load();
+    for (;;) {
+        if (current == 0 || collectorPid(current) != self) {
+            return false;
+        }
+        if (segment->collector.compare_exchange_weak(current, collectorWord(self, monotonicSeconds()))) {
+            return true;
+        }
+    }
+}
+
+// Unregister this process as the collector
+void ResultsRing::releaseCollector() {
+    if (!segment) {
+        return;
+    }
+
+    pid_t self = getpid();
+    uint64_t current = segment->collector.load();
+    while (current != 0 && collectorPid(current) == self) {
+        if (segment->collector.compare_exchange_weak(current, 0)) {
+            return;
+        }
+    }
+}
+
+// Drain the results ring into resultsPath until SIGINT/SIGTERM, returns exit status
+int runResultsCollector(const std::string& resultsPath) {
+    ResultsRing ring;
+    if (!ring.attach()) {
+        std::cerr << "Cannot map the shared results ring." << std::endl;
+        return 1;
+    }
+
+    if (!ring.claimCollector()) {
+        std::cerr << "Another results collector is already running." << std::endl;
+        return 1;
+    }
+
+    std::ofstream resultFile(resultsPath.c_str(), std::ios::app);
+    if (!resultFile.is_open()) {
+        std::cerr << "Cannot open " << resultsPath << " for appending." << std::endl;
+        ring.releaseCollector();
+        return 1;
+    }
+
+    signal(SIGINT, stopCollector);
+    signal(SIGTERM, stopCollector);
+
+    std::string line;
+    bool registered = true;
+    while (collectorRunning && (registered = ring.heartbeat())) {
+        bool popped = false;
+        // Check ownership before every line; a collector that stalled may have been replaced
+        while ((registered = ring.heartbeat()) && ring.pop(line)) {
+            if (!line.empty()) {
+                resultFile << line << '\n';
+            }
+            popped = true;
+        }
+        if (popped) {
+            resultFile.flush();
+        } else if (registered && ring.skipStalled()) {
+            std::cerr << "Skipped a result slot left unfinished by a crashed game." << std::endl;
+        } else if (registered) {
+            ring.waitForPush();
+        }
+    }
+
+    if (!registered) {
+        // Another collector took over after a stall; it owns the ring now
+        std::cerr << "Another results collector took over, stopping." << std::endl;
+        return 1;
+    }
+
+    // Stop new pushes first, then write out whatever is queued until producers that
+    // saw this collector have finished
+    ring.releaseCollector();
+    for (int i = 0; i < kShutdownRetries; i++) {
+        while (ring.pop(line)) {
+            if (!line.empty()) {
+                resultFile << line << '\n';
+            }
+        }
+        if (ring.idle()) {
+            break;
+        }
+        if (!ring.skipStalled()) {
+            usleep(kShutdownStepUs);
+        }
+    }
+    resultFile.close();
+
+    return 0;
+}
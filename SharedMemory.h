@@ -0,0 +1,94 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <semaphore.h>
+
+// Host-local shared memory used when many dog_matching processes run on one machine.
+// Finished games go through a multi-producer ring that a single collector drains to disk.
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "Shared memory segments need address-free atomics");
+
+// One ring slot; sequence is even when free and odd when holding a line.
+// A published empty line marks a slot its producer gave up on.
+struct ResultSlot {
+    static const int kLineSize = 256;
+
+    std::atomic<uint64_t> sequence;
+    char line[kLineSize];
+};
+
+// Layout of the results ring segment
+struct ResultsSegment {
+    static const uint32_t kVersion = 4;
+    static const uint64_t kSlotCount = 1024; // Room for every terminal on a host to finish several games at once
+
+    std::atomic<uint32_t> ready;     // Set last by the creating process
+    uint32_t version;                // Layout version, must match kVersion
+    std::atomic<uint64_t> collector; // Collector pid (high 32 bits) and last heartbeat (low 32 bits), 0 if none
+    std::atomic<uint64_t> head;      // Next position claimed by a producer
+    std::atomic<uint64_t> tail;      // Next position read by the collector
+    sem_t wakeup;                    // Posted on every push to wake the collector
+    ResultSlot slots[kSlotCount];
+};
+
+// Multi-producer, single-consumer ring of finished game result lines
+class ResultsRing {
+private:
+    ResultsSegment* segment; // Mapped ring, null when not attached
+    bool stallSeen;          // Collector only: is tail waiting on an unwritten slot
+    uint64_t stalledAt;      // Collector only: position of that slot
+    uint32_t stalledSince;   // Collector only: when it was first seen unwritten
+
+    // Write one line into the next free slot, returns false if the ring is full
+    bool enqueue(const std::string& line);
+
+public:
+    // Constructor
+    ResultsRing();
+
+    // Destructor
+    ~ResultsRing();
+
+    // Map the ring, creating it if needed
+    bool attach();
+
+    // Is a collector process currently draining the ring
+    bool hasCollector() const;
+
+    // Queue one result line for the running collector, returns false if there is none,
+    // the ring is full or unavailable; the caller then writes the line itself
+    bool push(const std::string& line);
+
+    // Is every claimed slot consumed (collector only)
+    bool idle() const;
+
+    // Take the oldest result line (collector only), returns false if empty;
+    // an empty line is a slot its producer gave up on and should not be written
+    bool pop(std::string& line);
+
+    // Skip the oldest slot if its producer claimed it and died before writing it
+    // (collector only), returns true if a slot was skipped
+    bool skipStalled();
+
+    // Sleep until a producer pushes or the poll interval passes (collector only)
+    void waitForPush();
+
+    // Register this process as the collector, returns false if another one is alive
+    bool claimCollector();
+
+    // Tell producers this collector is still alive, returns false if another one took over
+    bool heartbeat();
+
+    // Unregister this process as the collector
+    void releaseCollector();
+};
+
+// Drain the results ring into resultsPath until SIGINT/SIGTERM, returns exit status
+int runResultsCollector(const std::string& resultsPath);
+
+#endif // SHARED_MEMORY_H
@@ -1,8 +1,15 @@
 #include <locale>
 #include <clocale>
+#include <string>
 #include "DogMatchingGame.h"
+#include "SharedMemory.h"
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Collector mode: drain results from every game on this host into the history file
+    if (argc > 1 && std::string(argv[1]) == "--collector") {
+        return runResultsCollector("game_results.txt");
+    }
+    
     // Set localization to support multilingual characters
     std::setlocale(LC_ALL, "");
     // Ensure output streams use UTF-8 encoding